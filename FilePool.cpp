@@ -1,33 +1,27 @@
 #include "FilePool.h"
 
-FilePool::FilePool(fs::path path, std::size_t files_count, std::ios_base::openmode mode)
-    : _mode(mode), _path(std::move(path)), _files_count(files_count) {
+FilePool::FilePool(fs::path path, std::size_t files_count, std::ios_base::openmode mode, std::size_t index_size)
+    : _mode(mode), _path(std::move(path)), _index_size(index_size), _files_count(files_count) {
+    _buffers.resize(_files_count);
     _file_pool.resize(_files_count);
-    fs::path filename = _path.filename();
-    fs::path dir = _path.remove_filename();
+    _indexes.resize(_files_count, SparseIndex{1, 0, {}});
     for (std::size_t i = 0; i < _files_count; ++i) {
-        _file_pool[i].open(dir/(filename.string() + std::to_string(i)), mode);
+        _file_pool[i].open(file_path(i), mode);
         if (!_file_pool[i].is_open()) {
-            std::cerr << "File opening error: " << filename.string() + std::to_string(i) << std::endl;
+            std::cerr << "File opening error: " << file_path(i).filename().string() << std::endl;
         }
     }
 }
 
 FilePool::~FilePool() {
-    for (auto& file : _file_pool) {
-        file.close();
+    for (std::size_t i = 0; i < _file_pool.size(); ++i) {
+        close(i);
     }
 }
 
 void FilePool::write(std::size_t index, const Data& data) {
     if (index < _file_pool.size() && (std::ios::out & _mode)) {
-        _file_pool[index] << data.key << " " << data.value << std::endl;
-    }
-}
-
-void FilePool::write(std::size_t index, const std::vector<Data> &v_data) {
-    if (index < _file_pool.size() && (std::ios::out & _mode)) {
-        for (const auto& data : v_data)
+        add_to_index(index, data);
         _file_pool[index] << data.key << " " << data.value << std::endl;
     }
 }
@@ -52,5 +46,81 @@ std::vector<Data> FilePool::read_all(std::size_t index) {
 }
 
 void FilePool::close(std::size_t index) {
-    _file_pool[index].close();
+    if (_file_pool[index].is_open()) {
+        _file_pool[index].close();
+        write_index(index);
+    }
+}
+
+void FilePool::rebind(std::size_t index) {
+    if (index < _file_pool.size()) {
+        _file_pool[index].close();
+        _indexes[index] = SparseIndex{1, 0, {}};
+        _buffers[index].assign(_buffer_size, '\0');
+        _file_pool[index].rdbuf()->pubsetbuf(_buffers[index].data(), static_cast<std::streamsize>(_buffers[index].size()));
+        _file_pool[index].open(file_path(index), _mode);
+        if (!_file_pool[index].is_open()) {
+            std::cerr << "File opening error: " << file_path(index).filename().string() << std::endl;
+        }
+    }
+}
+
+fs::path FilePool::file_path(std::size_t index) const {
+    return _path.parent_path()/(_path.filename().string() + std::to_string(index));
+}
+
+SparseIndex FilePool::read_index(std::size_t index) const {
+    SparseIndex sparse_index;
+    std::ifstream file(index_path(index));
+    if (file >> sparse_index.stride >> sparse_index.count) {
+        SparseIndex::Entry entry;
+        while (file >> entry.key >> entry.offset) {
+            sparse_index.entries.push_back(entry);
+        }
+    }
+    return sparse_index;
+}
+
+void FilePool::seek(std::size_t index, std::streamoff offset) {
+    if (index < _file_pool.size() && (std::ios::in & _mode)) {
+        _file_pool[index].clear();
+        _file_pool[index].seekg(offset);
+    }
+}
+
+fs::path FilePool::index_path(std::size_t index) const {
+    return _path.parent_path()/(_path.filename().string() + std::to_string(index) + ".idx");
+}
+
+void FilePool::add_to_index(std::size_t index, const Data& data) {
+    if (_index_size != 0) {
+        SparseIndex& sparse_index = _indexes[index];
+        if (sparse_index.count % sparse_index.stride == 0 && sparse_index.entries.size() == _index_size) {
+            for (std::size_t i = 1; i * 2 < sparse_index.entries.size(); ++i) {
+                sparse_index.entries[i] = std::move(sparse_index.entries[i * 2]);
+            }
+            sparse_index.entries.resize((sparse_index.entries.size() + 1) / 2);
+            sparse_index.stride *= 2;
+        }
+        if (sparse_index.count % sparse_index.stride == 0) {
+            sparse_index.entries.push_back({data.key, static_cast<std::streamoff>(_file_pool[index].tellp())});
+        }
+        ++sparse_index.count;
+    }
+}
+
+void FilePool::write_index(std::size_t index) {
+    if (!(std::ios::out & _mode)) {
+        return;
+    }
+    if (_index_size == 0) {
+        std::error_code error;
+        fs::remove(index_path(index), error);
+        return;
+    }
+    std::ofstream file(index_path(index));
+    file << _indexes[index].stride << " " << _indexes[index].count << "\n";
+    for (const auto& entry : _indexes[index].entries) {
+        file << entry.key << " " << entry.offset << "\n";
+    }
 }
@@ -7,6 +7,8 @@
 #include <vector>
 #include <string>
 
+#include "LocalAllocator.h"
+
 namespace fs = std::filesystem;
 
 struct Data {
@@ -18,28 +20,69 @@ struct Data {
     }
 };
 
+/// <summary>
+/// Struct SparseIndex - every Nth key of a sorted file with its byte offset, N is the stride.
+/// </summary>
+struct SparseIndex {
+    struct Entry {
+        std::string key;
+        std::streamoff offset;
+    };
+
+    std::size_t stride {0};
+    std::size_t count {0};
+    std::vector<Entry> entries;
+};
+
 /// <summary>
 /// Class FilePool - works with a file pool.
 /// </summary>
 /// <param name="path">Path to the files, (including the filename).</param>
 /// <param name="files_count">Count of files.</param>
 /// <param name="mode">Opening mode.</param>
+/// <param name="index_size">Maximal number of indexed keys in a file, the stride doubles when the index is full
+/// (0 - the files are not indexed).</param>
 class FilePool {
 public:
-    FilePool(fs::path path, std::size_t files_count, std::ios_base::openmode mode);
+    FilePool(fs::path path, std::size_t files_count, std::ios_base::openmode mode, std::size_t index_size = 0);
     virtual ~FilePool();
 
     void write(std::size_t index, const Data& data);
-    void write(std::size_t index, const std::vector<Data>& v_data);
+    template <typename Allocator>
+    void write(std::size_t index, const std::vector<Data, Allocator>& v_data) {
+        for (const auto& data : v_data) {
+            write(index, data);
+        }
+    }
 
     Data read(std::size_t index);
     std::vector<Data> read_all(std::size_t index);
     void close(std::size_t index);
+    /// <summary>
+    /// Reopens the file with a buffer on fresh pages touched by the calling thread. Must be called before any I/O on the file.
+    /// </summary>
+    void rebind(std::size_t index);
+
+    /// <summary>
+    /// Reads the index written next to the file. The stride is 0 if the file is not indexed.
+    /// </summary>
+    SparseIndex read_index(std::size_t index) const;
+    void seek(std::size_t index, std::streamoff offset);
 
 private:
+    fs::path file_path(std::size_t index) const;
+    fs::path index_path(std::size_t index) const;
+    void add_to_index(std::size_t index, const Data& data);
+    void write_index(std::size_t index);
+
+    static constexpr std::size_t _buffer_size {1 << 16};
+
+    std::vector<std::vector<char, LocalAllocator<char>>> _buffers;
     std::vector<std::fstream> _file_pool;
     std::ios_base::openmode _mode;
     fs::path _path;
+    std::size_t _index_size;
+    std::vector<SparseIndex> _indexes;
 
 protected:
     std::size_t _files_count;
@@ -0,0 +1,31 @@
+#include <cmath>
+
+#include "KeySplitter.h"
+
+KeySplitter::KeySplitter(std::size_t data_count, std::size_t ranges_count)
+        : _ranges_count(ranges_count) {
+    _range_size = std::round(static_cast<long double>(data_count) / ranges_count);
+}
+
+void KeySplitter::add(const std::string& key, std::size_t weight) {
+    if (_data_index + _size_exceeding >= _range_size && !_next_range_pending &&
+        _boundaries.size() + 1 < _ranges_count) {
+        _size_exceeding = 0;
+        _next_range_pending = true;
+    }
+    if (_next_range_pending) {
+        if (key != _prev_key) {
+            _boundaries.push_back(key);
+            _next_range_pending = false;
+            _data_index = 0;
+        } else {
+            _size_exceeding += weight;
+        }
+    }
+    _prev_key = key;
+    _data_index += weight;
+}
+
+const std::vector<std::string>& KeySplitter::boundaries() const {
+    return _boundaries;
+}
@@ -0,0 +1,38 @@
+#ifndef KEYSPLITTER_H
+#define KEYSPLITTER_H
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Class KeySplitter - splits a sorted sequence of keys into ranges of approximately equal size, never splitting a key.
+/// </summary>
+/// <param name="data_count">Total number of data rows.</param>
+/// <param name="ranges_count">Count of ranges.</param>
+class KeySplitter {
+public:
+    KeySplitter(std::size_t data_count, std::size_t ranges_count);
+
+    /// <summary>
+    /// Adds the next key standing for weight rows.
+    /// </summary>
+    void add(const std::string& key, std::size_t weight = 1);
+    /// <summary>
+    /// First keys of the ranges after the first one. Fewer than ranges_count - 1 if there are not enough distinct keys.
+    /// </summary>
+    const std::vector<std::string>& boundaries() const;
+
+private:
+    std::size_t _ranges_count;
+    std::size_t _range_size;
+    std::size_t _data_index {0};
+    std::size_t _size_exceeding {0};
+
+    std::vector<std::string> _boundaries;
+    std::string _prev_key;
+    bool _next_range_pending {false};
+
+};
+
+
+#endif //KEYSPLITTER_H
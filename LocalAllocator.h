@@ -0,0 +1,56 @@
+#ifndef LOCALALLOCATOR_H
+#define LOCALALLOCATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/// <summary>
+/// Class LocalAllocator - allocates memory from fresh anonymous pages, which are placed on the NUMA node
+/// of the thread that first touches them. Falls back to std::allocator where mmap is not available.
+/// </summary>
+template <typename T>
+class LocalAllocator {
+public:
+    using value_type = T;
+
+    LocalAllocator() noexcept = default;
+    template <typename U>
+    LocalAllocator(const LocalAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+#ifdef __linux__
+        void* memory = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(memory);
+#else
+        return std::allocator<T>().allocate(n);
+#endif
+    }
+
+    void deallocate(T* memory, std::size_t n) noexcept {
+#ifdef __linux__
+        munmap(memory, n * sizeof(T));
+#else
+        std::allocator<T>().deallocate(memory, n);
+#endif
+    }
+
+    template <typename U>
+    bool operator ==(const LocalAllocator<U>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator !=(const LocalAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+
+#endif //LOCALALLOCATOR_H
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "MapReduce.h"
 
 MapReduce::MapReduce(int mappers_count, int reducers_count, fs::path work)
@@ -8,6 +10,11 @@ MapReduce::MapReduce(int mappers_count, int reducers_count, fs::path work)
 }
 
 void MapReduce::run(const fs::path& input, const fs::path& output) {
+    _statistics.assign(_placement.nodes_count(), NodeStatistics{});
+    for (std::size_t node = 0; node < _statistics.size(); ++node) {
+        _statistics[node].node = _placement.node_id(node);
+    }
+
     auto blocks = split_file(input, _mappers_count);
 
     run_mappers(blocks, input);
@@ -31,10 +38,22 @@ void MapReduce::set_reducer(reducer_type reducer) {
     _reducer = std::move(reducer);
 }
 
+void MapReduce::set_placement(PlacementPolicy policy) {
+    _placement = Placement(policy);
+}
+
+void MapReduce::set_index_samples(std::size_t index_samples) {
+    _index_samples = index_samples;
+}
+
 std::string MapReduce::get_output_filename() {
     return _reducer_out;
 }
 
+const std::vector<NodeStatistics>& MapReduce::get_statistics() const {
+    return _statistics;
+}
+
 std::vector<MapReduce::Block> MapReduce::split_file(const fs::path& path, std::size_t blocks_count) {
     std::uintmax_t file_size = fs::file_size(path);
     std::size_t block_size = file_size / blocks_count;
@@ -60,11 +79,14 @@ std::vector<MapReduce::Block> MapReduce::split_file(const fs::path& path, std::s
 
 std::size_t MapReduce::run_mappers(const std::vector<Block>& blocks, const fs::path& input) {
     FilePool mapper_out(_work/_mapper_out, _mappers_count, std::ios::out);
-    std::vector<std::future<std::size_t>> mappers_futures(_mappers_count);
+    std::vector<std::future<TaskResult>> mappers_futures(_mappers_count);
     for (std::size_t i_mapper = 0; i_mapper < _mappers_count; ++i_mapper) {
         mappers_futures[i_mapper] = std::async(std::launch::async, [&, i_mapper]() {
+            if (_placement.pin(i_mapper)) {
+                mapper_out.rebind(i_mapper);
+            }
             std::ifstream input_file(input, std::ios::binary);
-            std::vector<Data> result;
+            std::vector<Data, LocalAllocator<Data>> result;
             char ch;
             std::string line;
             input_file.seekg(blocks[i_mapper].from);
@@ -86,20 +108,30 @@ std::size_t MapReduce::run_mappers(const std::vector<Block>& blocks, const fs::p
 
             mapper_out.write(i_mapper, result);
 
-            return std::size_t {result.size()};
+            return TaskResult {result.size(), _placement.current_node()};
         });
     }
 
-    return std::accumulate(mappers_futures.begin(), mappers_futures.end(), 0,
-                           [](std::size_t a, std::future<std::size_t>& b) {return a + b.get();});
+    std::size_t data_size = 0;
+    for (auto& future : mappers_futures) {
+        TaskResult result = future.get();
+        ++_statistics[result.node].mappers;
+        _statistics[result.node].mapped += result.count;
+        data_size += result.count;
+    }
+    return data_size;
 }
 
 std::size_t MapReduce::run_combiners() {
     FilePool mapper_out(_work/_mapper_out, _mappers_count, std::ios::in);
-    FilePool combiner_out(_work/_combiner_out, _mappers_count, std::ios::out);
-    std::vector<std::future<std::size_t>> combiners_futures(_mappers_count);
+    FilePool combiner_out(_work/_combiner_out, _mappers_count, std::ios::out, _reducers_count * _index_samples);
+    std::vector<std::future<TaskResult>> combiners_futures(_mappers_count);
     for (std::size_t i = 0; i < _mappers_count; ++i) {
         combiners_futures[i] = std::async(std::launch::async, [&, i]() {
+            if (_placement.pin(i)) {
+                mapper_out.rebind(i);
+                combiner_out.rebind(i);
+            }
             std::size_t count = 0;
             Data result, temp;
             for (Data data = mapper_out.read(i); !data.key.empty();) {
@@ -114,57 +146,147 @@ std::size_t MapReduce::run_combiners() {
                 combiner_out.write(i, temp);
                 ++count;
             }
-            return count;
+            return TaskResult {count, _placement.current_node()};
         });
     }
 
-    return std::accumulate(combiners_futures.begin(), combiners_futures.end(), 0,
-                           [](std::size_t a, std::future<std::size_t>& b) {return a + b.get();});
+    std::size_t data_size = 0;
+    for (auto& future : combiners_futures) {
+        TaskResult result = future.get();
+        ++_statistics[result.node].combiners;
+        _statistics[result.node].combined += result.count;
+        data_size += result.count;
+    }
+    return data_size;
+}
+
+std::vector<MapReduce::Range> MapReduce::split_keys(const std::vector<SparseIndex>& indexes,
+                                                    std::size_t data_size, std::size_t ranges_count) {
+    struct Sample {
+        const std::string* key;
+        std::size_t weight;
+    };
+
+    std::vector<Sample> samples;
+    for (const auto& index : indexes) {
+        for (std::size_t i = 0; i < index.entries.size(); ++i) {
+            samples.push_back({&index.entries[i].key, std::min(index.stride, index.count - i * index.stride)});
+        }
+    }
+    std::stable_sort(samples.begin(), samples.end(),
+                     [](const Sample& a, const Sample& b) {return *a.key < *b.key;});
+
+    KeySplitter splitter(data_size, ranges_count);
+    for (const auto& sample : samples) {
+        splitter.add(*sample.key, sample.weight);
+    }
+
+    std::vector<Range> ranges(1);
+    for (const auto& boundary : splitter.boundaries()) {
+        ranges.back().to = boundary;
+        ranges.push_back(Range{boundary, {}});
+    }
+    return ranges;
 }
 
-void MapReduce::run_shuffler(std::size_t data_size) const {
+std::streamoff MapReduce::seek_offset(const SparseIndex& index, const std::string& key) {
+    auto it = std::lower_bound(index.entries.begin(), index.entries.end(), key,
+                               [](const SparseIndex::Entry& entry, const std::string& k) {return entry.key < k;});
+    return it == index.entries.begin() ? 0 : std::prev(it)->offset;
+}
+
+void MapReduce::run_shuffler(std::size_t data_size) {
     struct FileData {
         Data data;
         std::size_t file_index;
     };
 
-    FilePool combiner_out(_work/_combiner_out, _mappers_count, std::ios::in);
-    ShufflerFilePool reducer_in(_work/_reducer_in, _reducers_count, std::ios::out, data_size);
-    std::vector<FileData> buffer;
-    for (std::size_t i = 0; i < _mappers_count; ++i) {
-        buffer.push_back(FileData{combiner_out.read(i), i});
+    std::vector<SparseIndex> indexes;
+    {
+        FilePool combiner_out(_work/_combiner_out, _mappers_count, std::ios::in);
+        for (std::size_t i = 0; i < _mappers_count; ++i) {
+            indexes.push_back(combiner_out.read_index(i));
+        }
     }
+    auto ranges = split_keys(indexes, data_size, _reducers_count);
 
-    while (!buffer.empty()) {
-        auto min_it = std::min_element(buffer.begin(), buffer.end(),
-            [](const FileData &a, const FileData &b) {return a.data.key < b.data.key;});
+    FilePool reducer_in(_work/_reducer_in, _reducers_count, std::ios::out);
+    std::vector<std::future<TaskResult>> shufflers_futures(ranges.size());
+    for (std::size_t i_reducer = 0; i_reducer < ranges.size(); ++i_reducer) {
+        shufflers_futures[i_reducer] = std::async(std::launch::async, [&, i_reducer]() {
+            if (_placement.pin(i_reducer)) {
+                reducer_in.rebind(i_reducer);
+            }
+            const Range& range = ranges[i_reducer];
+            auto in_range = [&range](const Data& data) {
+                return !data.key.empty() && (range.to.empty() || data.key < range.to);
+            };
 
-        reducer_in.sequential_write(min_it->data);
+            FilePool combiner_out(_work/_combiner_out, _mappers_count, std::ios::in);
+            std::vector<FileData> buffer;
+            for (std::size_t i = 0; i < _mappers_count; ++i) {
+                combiner_out.seek(i, seek_offset(indexes[i], range.from));
+                Data data = combiner_out.read(i);
+                while (!data.key.empty() && data.key < range.from) {
+                    data = combiner_out.read(i);
+                }
+                if (in_range(data)) {
+                    buffer.push_back(FileData{data, i});
+                } else {
+                    combiner_out.close(i);
+                }
+            }
 
-        min_it->data = combiner_out.read(min_it->file_index);
-        if (min_it->data.key.empty()) {
-            combiner_out.close(min_it->file_index);
-            buffer.erase(min_it);
-        }
+            std::size_t count = 0;
+            while (!buffer.empty()) {
+                auto min_it = std::min_element(buffer.begin(), buffer.end(),
+                    [](const FileData &a, const FileData &b) {return a.data.key < b.data.key;});
+
+                reducer_in.write(i_reducer, min_it->data);
+                ++count;
+
+                min_it->data = combiner_out.read(min_it->file_index);
+                if (!in_range(min_it->data)) {
+                    combiner_out.close(min_it->file_index);
+                    buffer.erase(min_it);
+                }
+            }
+            return TaskResult {count, _placement.current_node()};
+        });
+    }
+
+    for (auto& future : shufflers_futures) {
+        TaskResult result = future.get();
+        ++_statistics[result.node].shufflers;
+        _statistics[result.node].shuffled += result.count;
     }
 }
 
 void MapReduce::run_reducers(const fs::path& output) {
     FilePool reducer_in(_work/_reducer_in, _reducers_count, std::ios::in);
     FilePool reducer_out(output/_reducer_out, _reducers_count, std::ios::out);
-    std::vector<std::future<void>> reducers_futures(_reducers_count);
+    std::vector<std::future<TaskResult>> reducers_futures(_reducers_count);
     for (std::size_t i_reducer = 0; i_reducer < _reducers_count; ++i_reducer) {
         reducers_futures[i_reducer] = std::async(std::launch::async, [&, i_reducer]() {
+            if (_placement.pin(i_reducer)) {
+                reducer_in.rebind(i_reducer);
+                reducer_out.rebind(i_reducer);
+            }
+            std::size_t count = 0;
             Data result;
             for (Data data = reducer_in.read(i_reducer); !data.key.empty();) {
                 result = _reducer(result, data);
+                ++count;
                 data = reducer_in.read(i_reducer);
             }
             reducer_out.write(i_reducer, result);
+            return TaskResult {count, _placement.current_node()};
         });
     }
 
     for (auto& future : reducers_futures) {
-        future.wait();
+        TaskResult result = future.get();
+        ++_statistics[result.node].reducers;
+        _statistics[result.node].reduced += result.count;
     }
 }
@@ -2,15 +2,30 @@
 #include <functional>
 #include <future>
 #include <fstream>
-#include <numeric>
 
 #include "FilePool.h"
-#include "ShufflerFilePool.h"
+#include "KeySplitter.h"
+#include "Placement.h"
 
 using mapper_type = std::function<Data(const std::string&)>;
 using combiner_type = std::function<Data(const Data&, Data&)>;
 using reducer_type = std::function<Data(const Data&, const Data&)>;
 
+/// <summary>
+/// Struct NodeStatistics - tasks and records processed on one NUMA node (OS node id) during the last run.
+/// </summary>
+struct NodeStatistics {
+    int node {0};
+    std::size_t mappers {0};
+    std::size_t mapped {0};
+    std::size_t combiners {0};
+    std::size_t combined {0};
+    std::size_t shufflers {0};
+    std::size_t shuffled {0};
+    std::size_t reducers {0};
+    std::size_t reduced {0};
+};
+
 /// <summary>
 /// Class MapReduce - MapReduce framework.
 /// </summary>
@@ -26,7 +41,13 @@ public:
     void set_mapper(mapper_type mapper);
     void set_combiner(combiner_type combiner);
     void set_reducer(reducer_type reducer);
+    void set_placement(PlacementPolicy policy);
+    /// <summary>
+    /// Sets the number of keys indexed per reducer in every combiner output, the files the shuffle seeks into.
+    /// </summary>
+    void set_index_samples(std::size_t index_samples);
     std::string get_output_filename();
+    const std::vector<NodeStatistics>& get_statistics() const;
 
 private:
     struct Block {
@@ -34,19 +55,42 @@ private:
         std::size_t to;
     };
 
+    struct Range {
+        std::string from;   // empty - no lower bound
+        std::string to;     // empty - no upper bound
+    };
+
+    struct TaskResult {
+        std::size_t count;
+        std::size_t node;
+    };
+
     static std::vector<Block> split_file(const fs::path& path, std::size_t blocks_count);
+    /// <summary>
+    /// Splits the keys into ranges of approximately equal size, weighting every index sample by the rows it stands for.
+    /// </summary>
+    static std::vector<Range> split_keys(const std::vector<SparseIndex>& indexes,
+                                         std::size_t data_size, std::size_t ranges_count);
+    /// <summary>
+    /// Offset of the last indexed key less than the given one.
+    /// </summary>
+    static std::streamoff seek_offset(const SparseIndex& index, const std::string& key);
     std::size_t run_mappers(const std::vector<Block>& blocks, const fs::path& input);
     std::size_t run_combiners();
-    void run_shuffler(std::size_t data_size) const;
+    void run_shuffler(std::size_t data_size);
     void run_reducers(const fs::path& output);
 
     std::size_t _mappers_count;
     std::size_t _reducers_count;
+    std::size_t _index_samples {64};
 
     mapper_type _mapper;
     combiner_type _combiner;
     reducer_type _reducer;
 
+    Placement _placement;
+    std::vector<NodeStatistics> _statistics;
+
     const std::string _mapper_out {"mapper_out"};
     const std::string _combiner_out {"combiner_out"};
     const std::string _reducer_in {"reducer_in"};
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "Placement.h"
+
+namespace fs = std::filesystem;
+
+Placement::Placement(PlacementPolicy policy)
+        : Placement(policy, read_topology()) {}
+
+Placement::Placement(PlacementPolicy policy, std::vector<NumaNode> nodes)
+        : _policy(policy), _nodes(std::move(nodes)) {
+    _nodes.erase(std::remove_if(_nodes.begin(), _nodes.end(),
+                                [](const NumaNode& node) {return node.cpus.empty();}),
+                 _nodes.end());
+    if (_nodes.empty()) {
+        _nodes.push_back({0, {0}});
+    }
+    for (const auto& node : _nodes) {
+        _cpus_count += node.cpus.size();
+    }
+}
+
+PlacementPolicy Placement::policy() const {
+    return _policy;
+}
+
+std::size_t Placement::nodes_count() const {
+    return _nodes.size();
+}
+
+int Placement::node_id(std::size_t node) const {
+    return _nodes[node].id;
+}
+
+std::size_t Placement::node_for(std::size_t task_index) const {
+    switch (_policy) {
+        case PlacementPolicy::Spread:
+            return task_index % _nodes.size();
+        case PlacementPolicy::Compact: {
+            std::size_t cpu_index = task_index % _cpus_count;
+            for (std::size_t node = 0; node < _nodes.size(); ++node) {
+                if (cpu_index < _nodes[node].cpus.size()) {
+                    return node;
+                }
+                cpu_index -= _nodes[node].cpus.size();
+            }
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+int Placement::cpu_for(std::size_t task_index) const {
+    switch (_policy) {
+        case PlacementPolicy::Spread: {
+            const auto& cpus = _nodes[node_for(task_index)].cpus;
+            return cpus[(task_index / _nodes.size()) % cpus.size()];
+        }
+        case PlacementPolicy::Compact: {
+            std::size_t cpu_index = task_index % _cpus_count;
+            for (const auto& node : _nodes) {
+                if (cpu_index < node.cpus.size()) {
+                    return node.cpus[cpu_index];
+                }
+                cpu_index -= node.cpus.size();
+            }
+            return -1;
+        }
+        default:
+            return -1;
+    }
+}
+
+bool Placement::pin([[maybe_unused]] std::size_t task_index) const {
+#ifdef __linux__
+    int cpu = cpu_for(task_index);
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    return false;
+#endif
+}
+
+std::size_t Placement::current_node() const {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    for (std::size_t node = 0; node < _nodes.size(); ++node) {
+        if (std::find(_nodes[node].cpus.begin(), _nodes[node].cpus.end(), cpu) != _nodes[node].cpus.end()) {
+            return node;
+        }
+    }
+#endif
+    return 0;
+}
+
+std::vector<int> Placement::parse_cpulist(const std::string& cpulist) {
+    std::vector<int> cpus;
+    std::istringstream list(cpulist);
+    std::string range;
+    while (std::getline(list, range, ',')) {
+        std::istringstream stream(range);
+        int from, to;
+        char dash;
+        if (!(stream >> from)) {
+            continue;
+        }
+        to = (stream >> dash >> to) ? to : from;
+        for (int cpu = from; cpu <= to; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> Placement::read_topology() {
+    std::vector<NumaNode> nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator("/sys/devices/system/node", error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](unsigned char ch) {return std::isdigit(ch) != 0;})) {
+            continue;
+        }
+        std::ifstream file(entry.path()/"cpulist");
+        std::string cpulist;
+        std::getline(file, cpulist);
+        std::vector<int> cpus = parse_cpulist(cpulist);
+        cpus.erase(std::remove_if(cpus.begin(), cpus.end(), [&](int cpu) {
+            return has_mask && (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed));
+        }), cpus.end());
+        nodes.push_back({std::stoi(name.substr(4)), std::move(cpus)});
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) {return a.id < b.id;});
+#endif
+    if (nodes.empty()) {
+        nodes.push_back({0, {}});
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            nodes.back().cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return nodes;
+}
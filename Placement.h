@@ -0,0 +1,59 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+enum class PlacementPolicy {
+    None,       // threads are left to the OS scheduler
+    Compact,    // tasks fill the cores of one NUMA node before moving to the next
+    Spread      // tasks are distributed round-robin across NUMA nodes
+};
+
+/// <summary>
+/// Struct NumaNode - OS id of a NUMA node and the CPUs of the node the process may run on.
+/// </summary>
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+/// <summary>
+/// Class Placement - pins worker threads to cores according to the NUMA topology.
+/// Nodes without allowed CPUs are skipped, node indexes refer to the remaining nodes.
+/// </summary>
+/// <param name="policy">Placement policy.</param>
+/// <param name="nodes">NUMA nodes (read from the system if omitted).</param>
+class Placement {
+public:
+    explicit Placement(PlacementPolicy policy = PlacementPolicy::None);
+    Placement(PlacementPolicy policy, std::vector<NumaNode> nodes);
+
+    PlacementPolicy policy() const;
+    std::size_t nodes_count() const;
+    int node_id(std::size_t node) const;
+    std::size_t node_for(std::size_t task_index) const;
+    int cpu_for(std::size_t task_index) const;
+    /// <summary>
+    /// Pins the calling thread to the core of the task, so memory it touches afterwards is allocated on that node.
+    /// </summary>
+    bool pin(std::size_t task_index) const;
+    std::size_t current_node() const;
+
+    /// <summary>
+    /// Parses a CPU list in the sysfs format, e.g. "0-3,8-11".
+    /// </summary>
+    static std::vector<int> parse_cpulist(const std::string& cpulist);
+
+private:
+    static std::vector<NumaNode> read_topology();
+
+    PlacementPolicy _policy;
+    std::vector<NumaNode> _nodes;
+    std::size_t _cpus_count {0};
+
+};
+
+
+#endif //PLACEMENT_H
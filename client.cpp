@@ -7,11 +7,12 @@ namespace fs = std::filesystem;
 
 int main(int argc, char** argv) {
 
-    if (argc != 4) {
-        std::cerr << "Usage: mapreduce <src> <mnum> <rnum>" << std::endl;
+    if (argc != 4 && argc != 5) {
+        std::cerr << "Usage: mapreduce <src> <mnum> <rnum> [<placement>]" << std::endl;
         std::cerr << " - <src> - source file path" << std::endl;
         std::cerr << " - <mnum> - number of threads to map" << std::endl;
         std::cerr << " - <rnum> - number of threads to reduce" << std::endl;
+        std::cerr << " - <placement> - thread placement: none (default), compact or spread" << std::endl;
 
         return 1;
     }
@@ -22,6 +23,19 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    PlacementPolicy placement {PlacementPolicy::None};
+    if (argc == 5) {
+        std::string policy{argv[4]};
+        if (policy == "compact") {
+            placement = PlacementPolicy::Compact;
+        } else if (policy == "spread") {
+            placement = PlacementPolicy::Spread;
+        } else if (policy != "none") {
+            std::cerr << "Unknown placement: " << policy << std::endl;
+            return 1;
+        }
+    }
+
     try {
         fs::path output{"./out/"};
         fs::create_directory(output);
@@ -29,6 +43,7 @@ int main(int argc, char** argv) {
         int reducers_count = std::stoi(argv[3]);
 
         MapReduce mapreduce(mappers_count, reducers_count);
+        mapreduce.set_placement(placement);
 
         int prefix_length = 1;
         while (true) {
@@ -80,6 +95,17 @@ int main(int argc, char** argv) {
             ++prefix_length;
         }
         std::cout << "Minimal prefix length = " << prefix_length << std::endl;
+        if (placement != PlacementPolicy::None) {
+            const auto& statistics = mapreduce.get_statistics();
+            for (std::size_t node = 0; node < statistics.size(); ++node) {
+                std::cout << "Node " << statistics[node].node << ": "
+                          << statistics[node].mappers << " mappers (" << statistics[node].mapped << " records), "
+                          << statistics[node].combiners << " combiners (" << statistics[node].combined << " records), "
+                          << statistics[node].shufflers << " shufflers (" << statistics[node].shuffled << " records), "
+                          << statistics[node].reducers << " reducers (" << statistics[node].reduced << " records)"
+                          << std::endl;
+            }
+        }
     } catch (const std::exception& exception) {
         std::cerr << "Exception: " << exception.what() << std::endl;
     }
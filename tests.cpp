@@ -1,4 +1,13 @@
 #include "gtest/gtest.h"
+#include <map>
+#include <random>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
 
 #include "MapReduce.h"
 
@@ -47,11 +56,11 @@ void create_test_files() {
     data_count = 30;
 }
 
-TEST(SequentialWrite, test) {
+TEST(KeySplitter, test) {
     create_test_files();
 
     std::ifstream input(TEST_DIR/"emails.txt");
-    int file_count = 5;
+    int ranges_count = 5;
     int prefix_length = 1;
 
     std::vector<std::string> prefixes;
@@ -62,27 +71,13 @@ TEST(SequentialWrite, test) {
         prefixes.push_back(prefix);
     }
     std::sort(prefixes.begin(), prefixes.end());
-    {
-        ShufflerFilePool pool(TEMP/"seq_test", file_count, std::ios::out, data_count);
-        for (const auto& prefix : prefixes) {
-            pool.sequential_write({prefix, "1"});
-        }
-    }
-    std::vector<std::vector<Data>> result;
-    {
-        FilePool pool(TEMP/"seq_test", file_count, std::ios::in);
-        for (int i = 0; i < file_count; ++i) {
-            result.push_back(pool.read_all(i));
-        }
+
+    KeySplitter splitter(data_count, ranges_count);
+    for (const auto& prefix : prefixes) {
+        splitter.add(prefix);
     }
-    std::vector<std::vector<Data>> expected {
-            { {"a", "1"}, {"a", "1"}, {"a", "1"}, {"a", "1"}, {"a", "1"}, {"b", "1"} },
-            { {"d", "1"}, {"e", "1"}, {"g", "1"}, {"g", "1"}, {"g", "1"}, {"g", "1"}, {"g", "1"}, {"g", "1"} },
-            { {"i", "1"}, {"j", "1"}, {"k", "1"}, {"l", "1"}, {"l", "1"}, {"l", "1"}, {"l", "1"}, {"l", "1"} },
-            { {"p", "1"}, {"s", "1"}, {"s", "1"}, {"s", "1"} },
-            { {"v", "1"}, {"v", "1"}, {"w", "1"}, {"y", "1"} }
-    };
-    ASSERT_EQ(result, expected);
+    std::vector<std::string> expected {"d", "i", "p", "v"};
+    ASSERT_EQ(splitter.boundaries(), expected);
 }
 
 std::pair<int, int> run_mapreduce() {
@@ -195,3 +190,219 @@ TEST(MapReduce, reducer_test) {
     };
     ASSERT_EQ(result, expected);
 }
+
+TEST(Placement, spread_test) {
+    Placement placement(PlacementPolicy::Spread, {{0, {0, 1}}, {2, {2, 3}}});
+    std::vector<std::size_t> nodes;
+    std::vector<int> cpus;
+    for (std::size_t i = 0; i < 5; ++i) {
+        nodes.push_back(placement.node_for(i));
+        cpus.push_back(placement.cpu_for(i));
+    }
+    ASSERT_EQ(nodes, (std::vector<std::size_t>{0, 1, 0, 1, 0}));
+    ASSERT_EQ(cpus, (std::vector<int>{0, 2, 1, 3, 0}));
+    ASSERT_EQ(placement.node_id(1), 2);
+}
+
+TEST(Placement, compact_test) {
+    Placement placement(PlacementPolicy::Compact, {{0, {0, 1}}, {2, {2, 3}}});
+    std::vector<std::size_t> nodes;
+    std::vector<int> cpus;
+    for (std::size_t i = 0; i < 5; ++i) {
+        nodes.push_back(placement.node_for(i));
+        cpus.push_back(placement.cpu_for(i));
+    }
+    ASSERT_EQ(nodes, (std::vector<std::size_t>{0, 0, 1, 1, 0}));
+    ASSERT_EQ(cpus, (std::vector<int>{0, 1, 2, 3, 0}));
+}
+
+TEST(Placement, parse_cpulist_test) {
+    ASSERT_EQ(Placement::parse_cpulist("0-3,8-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 9, 10, 11}));
+    ASSERT_EQ(Placement::parse_cpulist("5"), (std::vector<int>{5}));
+    ASSERT_EQ(Placement::parse_cpulist("\n"), (std::vector<int>{}));
+}
+
+#ifdef __linux__
+TEST(Placement, pin_test) {
+    Placement placement(PlacementPolicy::Spread);
+    for (std::size_t i = 0; i < 4; ++i) {
+        bool pinned = false;
+        int cpu = -1;
+        std::vector<int> affinity;
+        std::thread worker([&]() {
+            pinned = placement.pin(i);
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+            for (int c = 0; c < CPU_SETSIZE; ++c) {
+                if (CPU_ISSET(c, &cpu_set)) {
+                    affinity.push_back(c);
+                }
+            }
+            cpu = sched_getcpu();
+        });
+        worker.join();
+        ASSERT_TRUE(pinned);
+        ASSERT_EQ(affinity, (std::vector<int>{placement.cpu_for(i)}));
+        ASSERT_EQ(cpu, placement.cpu_for(i));
+    }
+}
+
+TEST(LocalAllocator, test) {
+    std::vector<char, LocalAllocator<char>> buffer(100, 'x');
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data()) % sysconf(_SC_PAGESIZE), 0);
+    ASSERT_EQ(buffer.back(), 'x');
+}
+#endif
+
+TEST(MapReduce, placement_statistics_test) {
+    create_test_files();
+    fs::path input{TEST_DIR/"emails.txt"};
+    MapReduce mapreduce(4, 3, TEMP);
+    mapreduce.set_placement(PlacementPolicy::Spread);
+    mapreduce.set_mapper([](const std::string &input) -> Data {
+        return {input, "1"};
+    });
+    mapreduce.set_combiner([](const Data &data, Data &) -> Data {
+        return data;
+    });
+    mapreduce.set_reducer([](const Data &, const Data &data) -> Data {
+        return data;
+    });
+    mapreduce.run(input, OUT);
+
+    NodeStatistics total;
+    for (const auto& node : mapreduce.get_statistics()) {
+        total.mappers += node.mappers;
+        total.mapped += node.mapped;
+        total.combiners += node.combiners;
+        total.combined += node.combined;
+        total.shufflers += node.shufflers;
+        total.shuffled += node.shuffled;
+        total.reducers += node.reducers;
+        total.reduced += node.reduced;
+    }
+    ASSERT_EQ(total.mappers, 4);
+    ASSERT_EQ(total.mapped, data_count);
+    ASSERT_EQ(total.combiners, 4);
+    ASSERT_EQ(total.combined, data_count);
+    ASSERT_EQ(total.shufflers, 3);
+    ASSERT_EQ(total.shuffled, data_count);
+    ASSERT_EQ(total.reducers, 3);
+    ASSERT_EQ(total.reduced, data_count);
+}
+
+TEST(SparseIndex, test) {
+    create_test_files();
+    std::vector<Data> records {
+            {"a", "1"}, {"a", "2"}, {"b", "1"}, {"c", "1"}, {"c", "2"}, {"d", "1"}, {"e", "1"}
+    };
+    {
+        FilePool pool(TEMP/"index_test", 1, std::ios::out, 4);
+        pool.write(0, records);
+    }
+    FilePool pool(TEMP/"index_test", 1, std::ios::in);
+    SparseIndex index = pool.read_index(0);
+    ASSERT_EQ(index.stride, 2);
+    ASSERT_EQ(index.count, records.size());
+    ASSERT_EQ(index.entries.size(), 4);
+
+    std::vector<Data> result;
+    for (std::size_t i = 0; i < index.entries.size(); ++i) {
+        pool.seek(0, index.entries[i].offset);
+        result.push_back(pool.read(0));
+    }
+    std::vector<Data> expected { {"a", "1"}, {"b", "1"}, {"c", "2"}, {"e", "1"} };
+    ASSERT_EQ(result, expected);
+}
+
+TEST(MapReduce, sparse_shuffler_test) {
+    create_test_files();
+    int mapper_count = 4, reducer_count = 3;
+    MapReduce mapreduce(mapper_count, reducer_count, TEMP);
+    mapreduce.set_index_samples(1);
+    mapreduce.set_mapper([](const std::string &input) -> Data {
+        std::string prefix = input.substr(0, 1);
+        std::transform(prefix.begin(), prefix.end(), prefix.begin(), ::tolower);
+        return {prefix, "1"};
+    });
+    mapreduce.set_combiner([](const Data &data, Data &) -> Data {
+        return data;
+    });
+    mapreduce.set_reducer([](const Data &, const Data &data) -> Data {
+        return data;
+    });
+    mapreduce.run(TEST_DIR/"emails.txt", OUT);
+
+    std::vector<std::vector<Data>> result;
+    {
+        FilePool pool(TEMP/"reducer_in", reducer_count, std::ios::in);
+        for (int i = 0; i < reducer_count; ++i) {
+            result.push_back(pool.read_all(i));
+        }
+    }
+    // at most 3 keys per file index: the combiner outputs (7-8 rows) end up with stride 4 and 2 entries
+    std::vector<std::string> sampled_keys;
+    {
+        FilePool pool(TEMP/"combiner_out", mapper_count, std::ios::in);
+        for (int i = 0; i < mapper_count; ++i) {
+            SparseIndex index = pool.read_index(i);
+            ASSERT_EQ(index.stride, 4);
+            ASSERT_EQ(index.entries.size(), 2);
+            for (const auto& entry : index.entries) {
+                sampled_keys.push_back(entry.key);
+            }
+        }
+    }
+
+    std::size_t total = 0;
+    std::map<std::string, std::size_t> key_reducer;
+    for (std::size_t i = 0; i < result.size(); ++i) {
+        if (i > 0 && !result[i].empty()) {
+            ASSERT_NE(std::find(sampled_keys.begin(), sampled_keys.end(), result[i].front().key), sampled_keys.end());
+        }
+        for (const auto& data : result[i]) {
+            auto [it, inserted] = key_reducer.emplace(data.key, i);
+            ASSERT_EQ(it->second, i);
+        }
+        total += result[i].size();
+    }
+    ASSERT_EQ(total, data_count);
+}
+
+TEST(MapReduce, balanced_shuffler_test) {
+    create_test_files();
+    std::size_t lines_count = 3000;
+    {
+        std::mt19937 generator;
+        std::ofstream file(TEST_DIR/"random.txt");
+        for (std::size_t i = 0; i < lines_count; ++i) {
+            std::string line;
+            for (int j = 0; j < 8; ++j) {
+                line += static_cast<char>('a' + generator() % 26);
+            }
+            file << line << "\n";
+        }
+    }
+    int mapper_count = 4, reducer_count = 3;
+    MapReduce mapreduce(mapper_count, reducer_count, TEMP);
+    mapreduce.set_mapper([](const std::string &input) -> Data {
+        return {input.substr(0, 3), "1"};
+    });
+    mapreduce.set_combiner([](const Data &data, Data &) -> Data {
+        return data;
+    });
+    mapreduce.set_reducer([](const Data &, const Data &data) -> Data {
+        return data;
+    });
+    mapreduce.run(TEST_DIR/"random.txt", OUT);
+
+    FilePool pool(TEMP/"reducer_in", reducer_count, std::ios::in);
+    std::size_t total = 0;
+    for (int i = 0; i < reducer_count; ++i) {
+        auto records = pool.read_all(i);
+        ASSERT_NEAR(records.size(), lines_count / reducer_count, lines_count / reducer_count / 20);
+        total += records.size();
+    }
+    ASSERT_EQ(total, lines_count);
+}